@@ -1,18 +1,52 @@
 #include "AST.h"
 
 #include <utility>
+#include "Emitter.h"
 
 namespace nepl {
     LiteralAstNode::LiteralAstNode(LiteralValue value) : value(std::move(value)) {}
 
+    void LiteralAstNode::emit(Emitter &emitter) const {
+        emitter.beginNode(AstKind::LITERAL);
+        emitter.field("value", value);
+        emitter.endNode();
+    }
+
     IdentifierAstNode::IdentifierAstNode(std::string name) : name(std::move(name)) {}
 
+    void IdentifierAstNode::emit(Emitter &emitter) const {
+        emitter.beginNode(AstKind::IDENTIFIER);
+        emitter.field("name", name);
+        emitter.endNode();
+    }
+
     MemberAstNode::MemberAstNode(std::string name, std::unique_ptr<IAstNode> parent) :
             name(std::move(name)), parent(std::move(parent)) {}
 
+    void MemberAstNode::emit(Emitter &emitter) const {
+        emitter.beginNode(AstKind::MEMBER);
+        emitter.field("name", name);
+        emitter.child("parent", *parent);
+        emitter.endNode();
+    }
+
     CallAstNode::CallAstNode(std::unique_ptr<IAstNode> function, std::vector<std::unique_ptr<IAstNode>> args) :
             function(std::move(function)), args(std::move(args)) {}
 
+    void CallAstNode::emit(Emitter &emitter) const {
+        emitter.beginNode(AstKind::CALL);
+        emitter.child("function", *function);
+        emitter.children("args", args);
+        emitter.endNode();
+    }
+
     IndexAstNode::IndexAstNode(std::unique_ptr<IAstNode> container, std::unique_ptr<IAstNode> index) :
             container(std::move(container)), index(std::move(index)) {}
+
+    void IndexAstNode::emit(Emitter &emitter) const {
+        emitter.beginNode(AstKind::INDEX);
+        emitter.child("container", *container);
+        emitter.child("index", *index);
+        emitter.endNode();
+    }
 }
@@ -11,10 +11,15 @@
 #include "common.h"
 
 namespace nepl {
+    class Emitter;
+
     /// Basic structure for a node of AST (abstract syntax tree)
     class IAstNode {
     public:
         virtual ~IAstNode() = default;
+
+        /// Write the node with its children
+        virtual void emit(Emitter &emitter) const = 0;
     };
 
     /// Value of literal
@@ -28,6 +33,8 @@ namespace nepl {
 
     public:
         explicit LiteralAstNode(LiteralValue value);
+
+        void emit(Emitter &emitter) const override;
     };
 
     /// AST node for accessing a variable
@@ -38,6 +45,8 @@ namespace nepl {
 
     public:
         explicit IdentifierAstNode(std::string name);
+
+        void emit(Emitter &emitter) const override;
     };
 
     /// AST node for accessing member of an object
@@ -51,6 +60,8 @@ namespace nepl {
 
     public:
         MemberAstNode(std::string name, std::unique_ptr<IAstNode> parent);
+
+        void emit(Emitter &emitter) const override;
     };
 
     /// AST node for function call
@@ -64,6 +75,8 @@ namespace nepl {
 
     public:
         CallAstNode(std::unique_ptr<IAstNode> function, std::vector<std::unique_ptr<IAstNode>> args);
+
+        void emit(Emitter &emitter) const override;
     };
 
     /// AST node for accessing item by index
@@ -77,6 +90,8 @@ namespace nepl {
 
     public:
         IndexAstNode(std::unique_ptr<IAstNode> container, std::unique_ptr<IAstNode> index);
+
+        void emit(Emitter &emitter) const override;
     };
 }
 
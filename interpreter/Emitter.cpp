@@ -0,0 +1,389 @@
+#include "Emitter.h"
+
+#include <charconv>
+#include <cstring>
+
+namespace nepl {
+    Emitter::Emitter(std::ostream &out, EmitFormat format, EmitKind kind) :
+            out(out), format(format), buffer(BUFFER_SIZE), used(0u), digits(), depth(0u) {
+        if (format == EmitFormat::BINARY) {
+            put("NEPL");
+            put(static_cast<char>(1)); //version
+            put(static_cast<char>(kind));
+        }
+    }
+
+    Emitter::~Emitter() {
+        flush();
+    }
+
+    void Emitter::flush() {
+        out.write(buffer.data(), static_cast<std::streamsize>(used));
+        used = 0u;
+    }
+
+    char *Emitter::reserve(std::size_t size) {
+        if (used + size > buffer.size()) {
+            flush();
+            if (size > buffer.size())
+                buffer.resize(size);
+        }
+        return buffer.data() + used;
+    }
+
+    void Emitter::put(char c) {
+        *reserve(1u) = c;
+        ++used;
+    }
+
+    void Emitter::put(std::string_view text) {
+        std::memcpy(reserve(text.size()), text.data(), text.size());
+        used += text.size();
+    }
+
+    void Emitter::putUnsigned(std::uint64_t value) {
+        auto begin = reserve(20u);
+        used = std::to_chars(begin, begin + 20, value).ptr - buffer.data();
+    }
+
+    void Emitter::putU32(std::uint32_t value) {
+        auto p = reserve(4u);
+        for (unsigned i = 0u; i < 4u; ++i)
+            p[i] = static_cast<char>(value >> (8u * i));
+        used += 4u;
+    }
+
+    void Emitter::putInteger(const Integer &value) {
+        auto p = reserve(mpz_sizeinbase(value.get_mpz_t(), 10) + 2u);
+        mpz_get_str(p, 10, value.get_mpz_t());
+        used += std::strlen(p);
+    }
+
+    void Emitter::putIntegerBits(const Integer &value) {
+        put(static_cast<char>(sgn(value) < 0));
+        auto p = reserve(4u + (mpz_sizeinbase(value.get_mpz_t(), 2) + 7u) / 8u);
+        std::size_t count;
+        mpz_export(p + 4, &count, -1, 1, -1, 0, value.get_mpz_t());
+        putU32(static_cast<std::uint32_t>(count));
+        used += count;
+    }
+
+    std::size_t Emitter::floatDigits(const Float &value, std::size_t significant) {
+        return significant ? significant : 4u + (mpf_get_prec(value.get_mpf_t()) + 128u) * 30103u / 100000u;
+    }
+
+    void Emitter::putFloat(const Float &value, std::size_t significant) {
+        auto maxDigits = floatDigits(value, significant);
+        //mpf_get_str needs space for the digits, sign and terminator
+        if (digits.size() < maxDigits + 2u)
+            digits.resize(maxDigits + 2u);
+        reserve(maxDigits + FLOAT_EXTRA); //the whole number is written without flushing
+        mp_exp_t exponent;
+        auto d = mpf_get_str(digits.data(), &exponent, 10, significant, value.get_mpf_t());
+        if (*d == '-') {
+            put('-');
+            ++d;
+        }
+        std::string_view mantissa(d);
+        if (mantissa.empty()) {
+            put('0');
+            return;
+        }
+
+        //the same choice of notation as %g
+        auto k = static_cast<long>(mantissa.size()), scientific = exponent - 1;
+        if (scientific >= -4 && scientific < static_cast<long>(significant ? significant : 21u)) {
+            if (exponent <= 0) {
+                put("0.");
+                for (auto i = exponent; i < 0; ++i)
+                    put('0');
+                put(mantissa);
+            } else if (exponent >= k) {
+                put(mantissa);
+                for (auto i = k; i < exponent; ++i)
+                    put('0');
+            } else {
+                put(mantissa.substr(0u, exponent));
+                put('.');
+                put(mantissa.substr(exponent));
+            }
+        } else {
+            put(mantissa[0]);
+            if (k > 1) {
+                put('.');
+                put(mantissa.substr(1u));
+            }
+            put(scientific < 0 ? "e-" : "e+");
+            auto magnitude = static_cast<std::uint64_t>(scientific < 0 ? -scientific : scientific);
+            if (magnitude < 10u)
+                put('0');
+            putUnsigned(magnitude);
+        }
+    }
+
+    void Emitter::putFloatString(const Float &value) {
+        //the length is patched after formatting, reserve guarantees that it stays in buffer
+        auto start = reserve(4u + floatDigits(value, 0u) + FLOAT_EXTRA) - buffer.data();
+        used += 4u;
+        putFloat(value, 0u);
+        auto length = static_cast<std::uint32_t>(used - start - 4u);
+        for (unsigned i = 0u; i < 4u; ++i)
+            buffer[start + i] = static_cast<char>(length >> (8u * i));
+    }
+
+    void Emitter::putString(std::string_view text) {
+        putU32(static_cast<std::uint32_t>(text.size()));
+        put(text);
+    }
+
+    void Emitter::putJsonString(std::string_view text) {
+        put('"');
+        std::size_t plain = 0u;
+        for (std::size_t i = 0u; i < text.size(); ++i) {
+            auto c = static_cast<unsigned char>(text[i]);
+            if (c >= 0x20u && c != '"' && c != '\\')
+                continue;
+            put(text.substr(plain, i - plain));
+            plain = i + 1u;
+            switch (c) {
+                case '"':
+                    put("\\\"");
+                    break;
+                case '\\':
+                    put("\\\\");
+                    break;
+                case '\n':
+                    put("\\n");
+                    break;
+                case '\r':
+                    put("\\r");
+                    break;
+                case '\t':
+                    put("\\t");
+                    break;
+                default:
+                    static const char HEX[] = "0123456789abcdef";
+                    put("\\u00");
+                    put(HEX[c >> 4u]);
+                    put(HEX[c & 0xFu]);
+            }
+        }
+        put(text.substr(plain));
+        put('"');
+    }
+
+    void Emitter::putValue(const LiteralValue &value) {
+        switch (value.index()) {
+            case 0:
+                if (format == EmitFormat::BINARY)
+                    putIntegerBits(get<0>(value));
+                else
+                    putInteger(get<0>(value));
+                break;
+            case 1:
+                if (format == EmitFormat::BINARY) {
+                    putFloatString(get<1>(value));
+                } else {
+                    putFloat(get<1>(value), format == EmitFormat::TEXT ? 6u : 0u);
+                }
+                break;
+            default:
+                if (format == EmitFormat::BINARY)
+                    putString(get<2>(value));
+                else
+                    putJsonString(get<2>(value));
+        }
+    }
+
+    void Emitter::putIndent() {
+        put('\n');
+        std::memset(reserve(2u * depth), ' ', 2u * depth);
+        used += 2u * depth;
+    }
+
+    void Emitter::emit(const Token &token) {
+        switch (format) {
+            case EmitFormat::TEXT:
+                put(tokenTypeName(token.type));
+                put('@');
+                putUnsigned(token.line);
+                switch (token.value.index()) {
+                    case 0:
+                        put(": ");
+                        put(get<0>(token.value));
+                        break;
+                    case 1:
+                        put(": ");
+                        putInteger(get<1>(token.value));
+                        break;
+                    case 2:
+                        put(": ");
+                        putFloat(get<2>(token.value), 6u);
+                        break;
+                    default:
+                        break;
+                }
+                put('\n');
+                break;
+            case EmitFormat::JSONL:
+                put(R"({"type":")");
+                put(tokenTypeName(token.type));
+                put(R"(","line":)");
+                putUnsigned(token.line);
+                switch (token.value.index()) {
+                    case 0:
+                        put(R"(,"value":)");
+                        putJsonString(get<0>(token.value));
+                        break;
+                    case 1:
+                        put(R"(,"value":)");
+                        putInteger(get<1>(token.value));
+                        break;
+                    case 2:
+                        put(R"(,"value":)");
+                        putFloat(get<2>(token.value), 0u);
+                        break;
+                    default:
+                        break;
+                }
+                put("}\n");
+                break;
+            case EmitFormat::BINARY:
+                put(static_cast<char>(token.type));
+                putU32(token.line);
+                switch (token.value.index()) {
+                    case 0:
+                        putString(get<0>(token.value));
+                        break;
+                    case 1:
+                        putIntegerBits(get<1>(token.value));
+                        break;
+                    case 2:
+                        putFloatString(get<2>(token.value));
+                        break;
+                    default:
+                        break;
+                }
+                break;
+        }
+    }
+
+    void Emitter::emit(const IAstNode &node) {
+        depth = 0u;
+        node.emit(*this);
+        if (format != EmitFormat::BINARY)
+            put('\n');
+    }
+
+    void Emitter::beginNode(AstKind kind) {
+        static const char *AST_KINDS[] = {"Literal", "Identifier", "Member", "Call", "Index"};
+        switch (format) {
+            case EmitFormat::TEXT:
+                put(AST_KINDS[static_cast<unsigned>(kind)]);
+                break;
+            case EmitFormat::JSONL:
+                put(R"({"node":")");
+                put(AST_KINDS[static_cast<unsigned>(kind)]);
+                put('"');
+                break;
+            case EmitFormat::BINARY:
+                put(static_cast<char>(kind));
+                break;
+        }
+    }
+
+    void Emitter::field(const char *name, const std::string &value) {
+        switch (format) {
+            case EmitFormat::TEXT:
+                put(' ');
+                put(value);
+                break;
+            case EmitFormat::JSONL:
+                put(",\"");
+                put(name);
+                put("\":");
+                putJsonString(value);
+                break;
+            case EmitFormat::BINARY:
+                putString(value);
+                break;
+        }
+    }
+
+    void Emitter::field(const char *name, const LiteralValue &value) {
+        switch (format) {
+            case EmitFormat::TEXT:
+                put(' ');
+                break;
+            case EmitFormat::JSONL:
+                put(",\"");
+                put(name);
+                put("\":");
+                break;
+            case EmitFormat::BINARY:
+                put(static_cast<char>(value.index()));
+                break;
+        }
+        putValue(value);
+    }
+
+    void Emitter::child(const char *name, const IAstNode &node) {
+        switch (format) {
+            case EmitFormat::TEXT:
+                ++depth;
+                putIndent();
+                put(name);
+                put(": ");
+                node.emit(*this);
+                --depth;
+                break;
+            case EmitFormat::JSONL:
+                put(",\"");
+                put(name);
+                put("\":");
+                node.emit(*this);
+                break;
+            case EmitFormat::BINARY:
+                node.emit(*this);
+                break;
+        }
+    }
+
+    void Emitter::children(const char *name, const std::vector<std::unique_ptr<IAstNode>> &nodes) {
+        switch (format) {
+            case EmitFormat::TEXT:
+                ++depth;
+                for (std::size_t i = 0u; i < nodes.size(); ++i) {
+                    putIndent();
+                    put(name);
+                    put('[');
+                    putUnsigned(i);
+                    put("]: ");
+                    nodes[i]->emit(*this);
+                }
+                --depth;
+                break;
+            case EmitFormat::JSONL:
+                put(",\"");
+                put(name);
+                put("\":[");
+                for (std::size_t i = 0u; i < nodes.size(); ++i) {
+                    if (i)
+                        put(',');
+                    nodes[i]->emit(*this);
+                }
+                put(']');
+                break;
+            case EmitFormat::BINARY:
+                putU32(static_cast<std::uint32_t>(nodes.size()));
+                for (const auto &node: nodes)
+                    node->emit(*this);
+                break;
+        }
+    }
+
+    void Emitter::endNode() {
+        if (format == EmitFormat::JSONL)
+            put('}');
+    }
+}
@@ -0,0 +1,146 @@
+/** @file
+ * @brief Header for Emitter class, writes tokens and AST for external tools
+ */
+
+#ifndef NEPL_EMITTER_H
+#define NEPL_EMITTER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+#include "Token.h"
+#include "AST.h"
+
+namespace nepl {
+    /// Output format of Emitter
+    enum class EmitFormat : unsigned char {
+        TEXT = 0, ///< Human-readable lines, same as operator<< for tokens
+        JSONL, ///< One JSON object per token or tree
+        BINARY, ///< Little-endian records, q.v. Emitter
+    };
+
+    /// What is written by Emitter
+    enum class EmitKind : unsigned char {
+        TOKENS = 0, AST,
+    };
+
+    /// Kind of AST node, written by IAstNode::emit
+    enum class AstKind : unsigned char {
+        LITERAL = 0, IDENTIFIER, MEMBER, CALL, INDEX,
+    };
+
+    /** @brief Buffered writer of tokens and trees in text, JSON Lines or binary format
+     *
+     * Output is collected in a large reusable buffer and written to the stream in big chunks;
+     * numbers are formatted directly into the buffer by GMP.
+     *
+     * Binary stream starts with "NEPL", version byte 1 and EmitKind byte. Lines and counts are u32, strings are
+     * u32 length and bytes. Token is u8 TokenType, u32 line and value: string for IDENTIFIER and STRING,
+     * u8 sign (1 if negative), u32 length and little-endian magnitude bytes for INTEGER, decimal string for FLOAT.
+     * Tree node is u8 AstKind followed by its fields in pre-order: LITERAL has u8 value index (0 integer, 1 float,
+     * 2 string) and the value, IDENTIFIER has name, MEMBER has name and parent, CALL has function,
+     * u32 number of arguments and arguments, INDEX has container and index.
+     */
+    class Emitter {
+    protected:
+        /// Size of buffer flushed to the stream
+        static constexpr std::size_t BUFFER_SIZE = 1u << 20u;
+
+        /// Maximal length of formatted Float except its digits: sign, point, zeros and exponent
+        static constexpr std::size_t FLOAT_EXTRA = 48u;
+
+        /// Destination of output
+        std::ostream &out;
+
+        const EmitFormat format;
+
+        /// Output not written to the stream yet
+        std::vector<char> buffer;
+
+        /// Number of used bytes of buffer
+        std::size_t used;
+
+        /// Reusable storage for digits of Float
+        std::vector<char> digits;
+
+        /// Nesting of the current tree node
+        unsigned depth;
+
+        /// Make space for size bytes in buffer and get pointer to it
+        char *reserve(std::size_t size);
+
+        void put(char c);
+
+        void put(std::string_view text);
+
+        void putUnsigned(std::uint64_t value);
+
+        void putU32(std::uint32_t value);
+
+        /// Decimal Integer
+        void putInteger(const Integer &value);
+
+        /// Sign and magnitude of Integer in binary format
+        void putIntegerBits(const Integer &value);
+
+        /// Maximal number of significant digits written by putFloat
+        static std::size_t floatDigits(const Float &value, std::size_t significant);
+
+        /// Decimal Float with significant digits like std::ostream (0 means full precision)
+        void putFloat(const Float &value, std::size_t significant);
+
+        /// Full precision Float as string with length in binary format
+        void putFloatString(const Float &value);
+
+        /// String with length in binary format
+        void putString(std::string_view text);
+
+        /// Quoted string with JSON escapes
+        void putJsonString(std::string_view text);
+
+        /// Value in the current format
+        void putValue(const LiteralValue &value);
+
+        /// Line break and indentation of text format
+        void putIndent();
+
+    public:
+        Emitter(std::ostream &out, EmitFormat format, EmitKind kind);
+
+        Emitter(const Emitter &) = delete;
+
+        Emitter &operator=(const Emitter &) = delete;
+
+        ~Emitter();
+
+        /// Write a token
+        void emit(const Token &token);
+
+        /// Write a tree
+        void emit(const IAstNode &node);
+
+        /// Write the buffer to the stream
+        void flush();
+
+        /// Start AST node, called by IAstNode::emit
+        void beginNode(AstKind kind);
+
+        /// String field of AST node
+        void field(const char *name, const std::string &value);
+
+        /// Literal value field of AST node
+        void field(const char *name, const LiteralValue &value);
+
+        /// Child node field of AST node
+        void child(const char *name, const IAstNode &node);
+
+        /// List of child nodes field of AST node
+        void children(const char *name, const std::vector<std::unique_ptr<IAstNode>> &nodes);
+
+        /// Finish AST node
+        void endNode();
+    };
+}
+
+#endif //NEPL_EMITTER_H
@@ -0,0 +1,356 @@
+#include "Heap.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+namespace nepl {
+    Root::Root(Heap &heap, GcObject *object) : object(object), heap(heap), prev(nullptr), next(heap.roots) {
+        if (next)
+            next->prev = this;
+        heap.roots = this;
+    }
+
+    Root::Root(const Root &other) : Root(other.heap, other.object) {}
+
+    Root &Root::operator=(const Root &other) {
+        object = other.object;
+        return *this;
+    }
+
+    Root::~Root() {
+        if (prev)
+            prev->next = next;
+        else
+            heap.roots = next;
+        if (next)
+            next->prev = prev;
+    }
+
+    std::byte *Heap::Space::allocate(std::size_t size) noexcept {
+        if (static_cast<std::size_t>(end - top) < size)
+            return nullptr;
+        auto res = top;
+        top += size;
+        return res;
+    }
+
+    bool Heap::Space::contains(const void *address) const noexcept {
+        return begin <= address && address < end;
+    }
+
+    /// Copying tracer of minor collection
+    class Heap::Evacuator : public Tracer {
+    protected:
+        Heap &heap;
+
+        /// Promote every live young object regardless of its age
+        const bool promoteAll;
+
+        /// Moved objects which are not traced yet
+        std::vector<GcObject *> worklist;
+
+        /// Has the traced object pointers to young objects?
+        bool sawYoung = false;
+
+    public:
+        Evacuator(Heap &heap, bool promoteAll) : heap(heap), promoteAll(promoteAll) {}
+
+        void visit(GcObject *&slot) override {
+            if (!slot || !isYoung(slot))
+                return;
+            auto head = header(slot);
+            if (heap.toSpace.contains(head)) { //already moved during this collection
+                sawYoung = true;
+                return;
+            }
+            if (!(head->flags & FLAG_FORWARDED)) {
+                auto size = head->size;
+                auto age = static_cast<std::uint8_t>(head->age + 1u);
+                std::byte *memory = nullptr;
+                bool old = promoteAll || age >= heap.config.tenureAge || !(memory = heap.toSpace.allocate(size));
+                if (old) {
+                    memory = heap.allocateOld(size);
+                    heap.stats.bytesPromoted += size;
+                }
+                new(memory) Header{nullptr, size, old ? FLAG_OLD : std::uint8_t(), age};
+                head->forward = slot->relocate(memory + sizeof(Header));
+                head->flags |= FLAG_FORWARDED;
+                worklist.push_back(head->forward);
+            }
+            slot = head->forward;
+            if (isYoung(slot))
+                sawYoung = true;
+        }
+
+        /// Evacuate objects referenced by the object, remember it in card table if they stay young
+        void scan(GcObject *object) {
+            sawYoung = false;
+            object->trace(*this);
+            if (sawYoung && !isYoung(object))
+                markCard(object);
+        }
+
+        /// Scan all moved objects
+        void drain() {
+            while (!worklist.empty()) {
+                auto object = worklist.back();
+                worklist.pop_back();
+                scan(object);
+            }
+        }
+    };
+
+    /// Marking tracer of major collection
+    class Heap::Marker : public Tracer {
+    protected:
+        /// Marked objects which are not traced yet
+        std::vector<GcObject *> worklist;
+
+    public:
+        void visit(GcObject *&slot) override {
+            if (!slot)
+                return;
+            auto head = header(slot);
+            if (head->flags & FLAG_MARKED)
+                return;
+            head->flags |= FLAG_MARKED;
+            worklist.push_back(slot);
+        }
+
+        /// Mark all objects reachable from visited ones
+        void drain() {
+            while (!worklist.empty()) {
+                auto object = worklist.back();
+                worklist.pop_back();
+                object->trace(*this);
+            }
+        }
+    };
+
+    Heap::Heap(HeapConfig config) : config(config), nextMajor(config.majorThreshold) {
+        auto round = [](std::size_t size) {
+            return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        };
+        auto edenSize = round(this->config.nurserySize), survivorSize = round(this->config.survivorSize);
+        nursery = static_cast<std::byte *>(std::aligned_alloc(ALIGNMENT, edenSize + 2 * survivorSize));
+        if (!nursery)
+            throw std::bad_alloc();
+        eden = {nursery, nursery, nursery + edenSize};
+        fromSpace = {eden.end, eden.end, eden.end + survivorSize};
+        toSpace = {fromSpace.end, fromSpace.end, fromSpace.end + survivorSize};
+    }
+
+    Heap::~Heap() {
+        release(eden);
+        release(fromSpace);
+        for (auto &block: blocks) {
+            walk(block.begin, block.top, [](Header *head) {
+                if (!(head->flags & FLAG_FREE))
+                    object(head)->~GcObject();
+            });
+            std::free(block.begin - CARDS_SIZE);
+        }
+        std::free(nursery);
+    }
+
+    Heap::Header *Heap::header(GcObject *object) noexcept {
+        return reinterpret_cast<Header *>(reinterpret_cast<std::byte *>(object) - sizeof(Header));
+    }
+
+    GcObject *Heap::object(Header *header) noexcept {
+        return reinterpret_cast<GcObject *>(reinterpret_cast<std::byte *>(header) + sizeof(Header));
+    }
+
+    bool Heap::isYoung(GcObject *object) noexcept {
+        return !(header(object)->flags & FLAG_OLD);
+    }
+
+    void Heap::markCard(GcObject *object) noexcept {
+        auto address = reinterpret_cast<std::uintptr_t>(header(object));
+        auto block = address & ~(BLOCK_SIZE - 1);
+        reinterpret_cast<std::uint8_t *>(block)[(address - block) / CARD_SIZE] = 1u;
+    }
+
+    template<typename F>
+    void Heap::walk(std::byte *begin, std::byte *end, F visitor) {
+        for (auto p = begin; p < end;) {
+            auto head = reinterpret_cast<Header *>(p);
+            p += head->size; //visitor may merge the header with the previous one
+            visitor(head);
+        }
+    }
+
+    void Heap::release(Space &space) {
+        walk(space.begin, space.top, [](Header *head) {
+            if (!(head->flags & (FLAG_FORWARDED | FLAG_FREE)))
+                object(head)->~GcObject();
+        });
+        space.top = space.begin;
+    }
+
+    void Heap::reserveOld(std::size_t size) {
+        if (oldSize + size > nextMajor)
+            collectMajor();
+        if (oldSize + size > config.oldSpaceLimit)
+            throw std::bad_alloc();
+    }
+
+    void Heap::addHole(std::byte *memory, std::size_t size) {
+        new(memory) Header{nullptr, static_cast<std::uint32_t>(size), FLAG_OLD | FLAG_FREE, 0u};
+        holes[std::min(size / ALIGNMENT, HOLE_CLASSES - 1u)].emplace_back(memory, size);
+    }
+
+    std::byte *Heap::allocateOld(std::size_t size) {
+        oldSize += size;
+        //every hole of an exact class fits, only the last class needs search
+        for (auto c = std::min(size / ALIGNMENT, HOLE_CLASSES - 1u); c < HOLE_CLASSES; ++c) {
+            auto &bucket = holes[c];
+            for (auto &hole: bucket) {
+                if (hole.second < size)
+                    continue;
+                auto [memory, holeSize] = hole;
+                hole = bucket.back();
+                bucket.pop_back();
+                if (holeSize > size)
+                    addHole(memory + size, holeSize - size);
+                return memory;
+            }
+        }
+
+        std::byte *memory;
+        if (blocks.empty() || !(memory = blocks.back().allocate(size))) {
+            auto block = static_cast<std::byte *>(std::aligned_alloc(BLOCK_SIZE, BLOCK_SIZE));
+            if (!block) {
+                oldSize -= size;
+                throw std::bad_alloc();
+            }
+            if (!blocks.empty() && blocks.back().top < blocks.back().end) { //the rest of the previous block
+                addHole(blocks.back().top, static_cast<std::size_t>(blocks.back().end - blocks.back().top));
+                blocks.back().top = blocks.back().end;
+            }
+            std::memset(block, 0, CARDS_SIZE);
+            blocks.push_back({block + CARDS_SIZE, block + CARDS_SIZE, block + BLOCK_SIZE});
+            memory = blocks.back().allocate(size);
+        }
+        return memory;
+    }
+
+    void Heap::evacuate(bool promoteAll) {
+        Evacuator evacuator(*this, promoteAll);
+        for (auto root = roots; root; root = root->next)
+            evacuator.visit(root->object);
+
+        //only objects with headers in dirty cards may point to young objects
+        std::vector<GcObject *> remembered;
+        for (auto &block: blocks) {
+            auto cards = reinterpret_cast<std::uint8_t *>(block.begin - CARDS_SIZE);
+            if (std::all_of(cards, cards + CARDS_SIZE, [](std::uint8_t card) { return !card; }))
+                continue;
+            walk(block.begin, block.top, [&](Header *head) {
+                auto card = (reinterpret_cast<std::byte *>(head) - (block.begin - CARDS_SIZE)) / CARD_SIZE;
+                if (cards[card] && !(head->flags & FLAG_FREE))
+                    remembered.push_back(object(head));
+            });
+            std::memset(cards, 0, CARDS_SIZE);
+        }
+        for (auto object: remembered)
+            evacuator.scan(object);
+        evacuator.drain();
+
+        release(eden);
+        release(fromSpace);
+        std::swap(fromSpace, toSpace);
+    }
+
+    void Heap::collectMinor() {
+        auto start = std::chrono::steady_clock::now();
+        evacuate(false);
+        ++stats.minorCollections;
+        finishPause(start);
+        if (oldSize > nextMajor)
+            collectMajor();
+        if (oldSize > config.oldSpaceLimit)
+            throw std::bad_alloc();
+    }
+
+    void Heap::collectMajor() {
+        auto start = std::chrono::steady_clock::now();
+        evacuate(true);
+
+        Marker marker;
+        for (auto root = roots; root; root = root->next)
+            marker.visit(root->object);
+        marker.drain();
+
+        for (auto &bucket: holes)
+            bucket.clear();
+        oldSize = 0u;
+        for (std::size_t i = 0u; i < blocks.size();) {
+            auto &block = blocks[i];
+            Header *freeRun = nullptr;
+            walk(block.begin, block.top, [&](Header *head) {
+                if (head->flags & FLAG_MARKED) {
+                    head->flags &= ~FLAG_MARKED;
+                    oldSize += head->size;
+                    if (freeRun)
+                        addHole(reinterpret_cast<std::byte *>(freeRun), freeRun->size);
+                    freeRun = nullptr;
+                    return;
+                }
+                if (!(head->flags & FLAG_FREE)) {
+                    object(head)->~GcObject();
+                    head->flags |= FLAG_FREE;
+                    stats.bytesReclaimed += head->size;
+                }
+                if (freeRun)
+                    freeRun->size += head->size;
+                else
+                    freeRun = head;
+            });
+            std::memset(block.begin - CARDS_SIZE, 0, CARDS_SIZE);
+
+            if (freeRun == reinterpret_cast<Header *>(block.begin) && i + 1 < blocks.size()) {
+                std::free(block.begin - CARDS_SIZE);
+                blocks.erase(blocks.begin() + static_cast<std::ptrdiff_t>(i));
+                continue;
+            }
+            if (freeRun) {
+                if (i + 1 < blocks.size())
+                    addHole(reinterpret_cast<std::byte *>(freeRun), freeRun->size);
+                else
+                    block.top = reinterpret_cast<std::byte *>(freeRun); //return the tail to bump allocation
+            }
+            ++i;
+        }
+
+        nextMajor = std::max(config.majorThreshold,
+                             static_cast<std::size_t>(static_cast<double>(oldSize) * config.majorGrowth));
+        ++stats.majorCollections;
+        finishPause(start);
+        if (oldSize > config.oldSpaceLimit)
+            throw std::bad_alloc();
+    }
+
+    void Heap::finishPause(std::chrono::steady_clock::time_point start) {
+        stats.lastPause = std::chrono::steady_clock::now() - start;
+        stats.maxPause = std::max(stats.maxPause, stats.lastPause);
+        stats.totalPause += stats.lastPause;
+    }
+
+    void Heap::collect() {
+        collectMajor();
+    }
+
+    const GcStats &Heap::getStats() const noexcept {
+        return stats;
+    }
+
+    std::size_t Heap::youngSize() const noexcept {
+        return static_cast<std::size_t>((eden.top - eden.begin) + (fromSpace.top - fromSpace.begin));
+    }
+
+    std::size_t Heap::oldSpaceSize() const noexcept {
+        return oldSize;
+    }
+}
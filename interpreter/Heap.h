@@ -0,0 +1,392 @@
+/** @file
+ * @brief Header for Heap class, the generational garbage collector for runtime objects
+ */
+
+#ifndef NEPL_HEAP_H
+#define NEPL_HEAP_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace nepl {
+    class Tracer;
+
+    class Heap;
+
+    /// Basic class for every object managed by Heap (persons, closures, strings, numbers, etc.)
+    class GcObject {
+    public:
+        virtual ~GcObject() = default;
+
+        /// Visit every GcPtr of the object with the tracer
+        virtual void trace(Tracer &tracer) = 0;
+
+        /// Move the object to memory at address and destroy the original, q.v. Managed
+        virtual GcObject *relocate(void *address) = 0;
+    };
+
+    /// Implementation of GcObject::relocate for class T, the only base class of T must be Managed<T>
+    template<typename T>
+    class Managed : public GcObject {
+    public:
+        GcObject *relocate(void *address) override {
+            auto &self = static_cast<T &>(*this);
+            auto moved = new(address) T(std::move(self));
+            self.~T();
+            return moved;
+        }
+    };
+
+    /// Pointer from one managed object to another, may be changed by Heap when the target is moved
+    template<typename T>
+    class GcPtr {
+        friend class Tracer;
+
+        friend class Heap;
+
+    protected:
+        /// Address of the target object
+        GcObject *object = nullptr;
+
+    public:
+        GcPtr() = default;
+
+        [[nodiscard]] T *get() const noexcept {
+            return static_cast<T *>(object);
+        }
+
+        T *operator->() const noexcept {
+            return get();
+        }
+
+        explicit operator bool() const noexcept {
+            return object != nullptr;
+        }
+    };
+
+    /// Is T a pointer to managed object which is not updated by Heap, e.g. GcObject * or GcPtr?
+    template<typename T>
+    inline constexpr bool isUnrootedPointer =
+            std::is_convertible_v<T, const GcObject *> && !std::is_same_v<T, std::nullptr_t>;
+
+    template<typename T>
+    inline constexpr bool isUnrootedPointer<GcPtr<T>> = true;
+
+    /// Visitor of pointers of managed objects
+    class Tracer {
+    protected:
+        /// Process a slot which contains pointer to managed object
+        virtual void visit(GcObject *&slot) = 0;
+
+    public:
+        virtual ~Tracer() = default;
+
+        template<typename T>
+        void operator()(GcPtr<T> &pointer) {
+            visit(pointer.object);
+        }
+    };
+
+    /// Base of Handle, linked into the list of roots of Heap
+    class Root {
+        friend class Heap;
+
+    protected:
+        /// Address of the rooted object, updated by Heap
+        GcObject *object;
+
+        /// Heap the root belongs to
+        Heap &heap;
+
+        /// Neighbours in the list of roots
+        Root *prev, *next;
+
+        Root(Heap &heap, GcObject *object);
+
+        Root(const Root &other);
+
+        Root &operator=(const Root &other);
+
+        ~Root();
+    };
+
+    /// Pointer from the native code (interpreter stack, globals) to a managed object, keeps the object alive
+    template<typename T>
+    class Handle : public Root {
+    public:
+        explicit Handle(Heap &heap, T *object = nullptr) : Root(heap, object) {}
+
+        [[nodiscard]] T *get() const noexcept {
+            return static_cast<T *>(object);
+        }
+
+        T *operator->() const noexcept {
+            return get();
+        }
+
+        explicit operator bool() const noexcept {
+            return object != nullptr;
+        }
+
+        Handle &operator=(T *other) noexcept {
+            object = other;
+            return *this;
+        }
+    };
+
+    /// Tunable limits of Heap
+    struct HeapConfig {
+        /// Size of the space where new objects are allocated, in bytes
+        std::size_t nurserySize = 4u << 20u;
+
+        /// Size of each of two spaces for objects survived minor collection, in bytes
+        std::size_t survivorSize = 512u << 10u;
+
+        /// Number of minor collections an object survives before it is promoted to old space
+        unsigned tenureAge = 2u;
+
+        /// Size of old space which triggers the first major collection, in bytes
+        std::size_t majorThreshold = 16u << 20u;
+
+        /// Growth of the major collection threshold relative to old space size after a major collection
+        double majorGrowth = 2.0;
+
+        /// Maximal size of old space, in bytes; std::bad_alloc is thrown when exceeded
+        std::size_t oldSpaceLimit = std::size_t(1u) << 30u;
+    };
+
+    /// Statistics of garbage collections
+    struct GcStats {
+        /// Number of collections of nursery only
+        std::size_t minorCollections = 0u;
+
+        /// Number of collections of the whole heap
+        std::size_t majorCollections = 0u;
+
+        /// Bytes moved from nursery to old space
+        std::size_t bytesPromoted = 0u;
+
+        /// Bytes of dead objects freed in old space
+        std::size_t bytesReclaimed = 0u;
+
+        /// Duration of the last collection
+        std::chrono::nanoseconds lastPause{};
+
+        /// Duration of the longest collection
+        std::chrono::nanoseconds maxPause{};
+
+        /// Total duration of all collections
+        std::chrono::nanoseconds totalPause{};
+    };
+
+    /** @brief Precise generational garbage collector
+     *
+     * New objects are bump-allocated in the nursery. Minor collection copies live nursery objects to a survivor
+     * space and promotes them to old space after HeapConfig::tenureAge collections. Pointers from old to young
+     * objects are found by card marking, so every store to a GcPtr must go through Heap::write.
+     * Minor collection copies live young objects and then runs destructors of dead ones, so its pause grows
+     * with the number of objects allocated since the previous collection.
+     * Major collection promotes all young objects, marks and sweeps old space and reclaims cycles. It is not
+     * incremental: the whole heap is processed in one pause, but it runs only when old space grows beyond
+     * the threshold.
+     *
+     * Objects may be moved by any allocation, so native code must keep pointers to them in Handle.
+     */
+    class Heap {
+        friend class Root;
+
+    public:
+        /// Size of an old space block, blocks are aligned to it
+        static constexpr std::size_t BLOCK_SIZE = 256u << 10u;
+
+        /// Size of memory covered by one card
+        static constexpr std::size_t CARD_SIZE = 512u;
+
+        /// Alignment of every object
+        static constexpr std::size_t ALIGNMENT = 16u;
+
+    protected:
+        /// Service data placed before every object
+        struct alignas(ALIGNMENT) Header {
+            /// New address of the moved object
+            GcObject *forward;
+
+            /// Size of the object with its header
+            std::uint32_t size;
+
+            /// Combination of FLAG_* values
+            std::uint8_t flags;
+
+            /// Number of survived minor collections
+            std::uint8_t age;
+        };
+
+        static constexpr std::uint8_t FLAG_OLD = 1u, FLAG_FORWARDED = 2u, FLAG_MARKED = 4u, FLAG_FREE = 8u;
+
+        /// Bytes at the beginning of an old space block occupied by its card table
+        static constexpr std::size_t CARDS_SIZE = BLOCK_SIZE / CARD_SIZE;
+
+        /// Contiguous memory with bump allocation
+        struct Space {
+            std::byte *begin = nullptr, *top = nullptr, *end = nullptr;
+
+            [[nodiscard]] std::byte *allocate(std::size_t size) noexcept;
+
+            [[nodiscard]] bool contains(const void *address) const noexcept;
+        };
+
+        class Evacuator;
+
+        class Marker;
+
+        HeapConfig config;
+
+        GcStats stats;
+
+        /// Space for new objects
+        Space eden;
+
+        /// Space with survived young objects and the empty space to copy them during the next minor collection
+        Space fromSpace, toSpace;
+
+        /// Memory of eden and survivor spaces
+        std::byte *nursery;
+
+        /// Aligned blocks of old space, bump allocation happens in the last one
+        std::vector<Space> blocks;
+
+        /// Number of size classes of free chunks in old space
+        static constexpr std::size_t HOLE_CLASSES = 64u;
+
+        /// Free chunks in old space: class i has chunks of i * ALIGNMENT bytes, the last class has bigger ones too
+        std::array<std::vector<std::pair<std::byte *, std::size_t>>, HOLE_CLASSES> holes;
+
+        /// Bytes occupied by objects in old space
+        std::size_t oldSize = 0u;
+
+        /// Size of old space which triggers the next major collection
+        std::size_t nextMajor;
+
+        /// Sentinel of the list of roots
+        Root *roots = nullptr;
+
+        static Header *header(GcObject *object) noexcept;
+
+        static bool isYoung(GcObject *object) noexcept;
+
+        /// Mark the card of the old object as containing pointers to young objects
+        static void markCard(GcObject *object) noexcept;
+
+        /// Run a major collection if allocating size bytes in old space would exceed the threshold
+        void reserveOld(std::size_t size);
+
+        /// Mark free chunk of old space and remember it for allocation
+        void addHole(std::byte *memory, std::size_t size);
+
+        /// Allocate memory in old space, growing it if needed
+        std::byte *allocateOld(std::size_t size);
+
+        static GcObject *object(Header *header) noexcept;
+
+        /// Call visitor for every header between begin and end in address order
+        template<typename F>
+        static void walk(std::byte *begin, std::byte *end, F visitor);
+
+        /// Destroy objects which are not moved from the space and reset it
+        static void release(Space &space);
+
+        /// Move live young objects to survivor space or old space; promote all of them if promoteAll is set
+        void evacuate(bool promoteAll);
+
+        /// Collect nursery only
+        void collectMinor();
+
+        /// Mark and sweep old space after promoting all young objects
+        void collectMajor();
+
+        /// Update pause statistics
+        void finishPause(std::chrono::steady_clock::time_point start);
+
+    public:
+        explicit Heap(HeapConfig config = {});
+
+        Heap(const Heap &) = delete;
+
+        Heap &operator=(const Heap &) = delete;
+
+        /// Destroy all objects; every Handle of the heap must be destroyed before
+        ~Heap();
+
+        /** @brief Create a managed object of class T, may trigger a collection
+         *
+         * A collection may move any object before the constructor runs, so managed objects are passed to it
+         * only in Handle and read after allocation. Constructor of T must not allocate.
+         */
+        template<typename T, typename... Args>
+        T *make(Args &&... args);
+
+        /// Store value into field of owner with write barrier
+        template<typename T>
+        static void write(GcObject *owner, GcPtr<T> &field, T *value) noexcept {
+            field.object = value;
+            if (value && !isYoung(owner) && isYoung(value))
+                markCard(owner);
+        }
+
+        /// Run a full collection immediately
+        void collect();
+
+        [[nodiscard]] const GcStats &getStats() const noexcept;
+
+        /// Bytes occupied by objects in nursery
+        [[nodiscard]] std::size_t youngSize() const noexcept;
+
+        /// Bytes occupied by objects in old space
+        [[nodiscard]] std::size_t oldSpaceSize() const noexcept;
+    };
+
+    template<typename T, typename... Args>
+    T *Heap::make(Args &&... args) {
+        static_assert(std::is_base_of_v<Managed<T>, T>, "managed class must derive from Managed<T>");
+        static_assert(alignof(T) <= ALIGNMENT, "managed class is overaligned");
+        constexpr auto size = (sizeof(Header) + sizeof(T) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        static_assert(size <= BLOCK_SIZE - CARDS_SIZE, "managed class is too big");
+        static_assert((!isUnrootedPointer<std::decay_t<Args>> && ...),
+                      "managed objects must be passed to make in Handle, pointers may be moved by collection");
+
+        std::byte *memory;
+        bool old = size > static_cast<std::size_t>(eden.end - eden.begin) / 4;
+        if (old) {
+            reserveOld(size);
+            memory = allocateOld(size);
+        } else if (!(memory = eden.allocate(size))) {
+            collectMinor();
+            memory = eden.allocate(size);
+        }
+
+        auto head = new(memory) Header{nullptr, static_cast<std::uint32_t>(size), old ? FLAG_OLD : std::uint8_t(), 0u};
+        T *result;
+        try {
+            result = new(memory + sizeof(Header)) T(std::forward<Args>(args)...);
+        } catch (...) {
+            if (old) {
+                oldSize -= size;
+                addHole(memory, size);
+            } else {
+                head->flags |= FLAG_FREE;
+            }
+            throw;
+        }
+        if (old)
+            markCard(result); //constructor might store young pointers without barrier
+        return result;
+    }
+}
+
+#endif //NEPL_HEAP_H
@@ -0,0 +1,471 @@
+#include "List.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+#if __has_include(<experimental/simd>)
+#include <experimental/simd>
+#define NEPL_SIMD
+#endif
+
+namespace nepl {
+    namespace {
+#ifdef NEPL_SIMD
+        namespace stdx = std::experimental;
+
+        /// Batch of unsigned 64-bit lanes, signed integers are processed in it to get wrapping arithmetic
+        using UintBatch = stdx::native_simd<std::uint64_t>;
+
+        using IntBatch = stdx::native_simd<std::int64_t>;
+
+        using FloatBatch = stdx::native_simd<double>;
+#endif
+
+        /// Get value as packed integer if possible
+        bool pack(const LiteralValue &value, std::int64_t &res) {
+            if (value.index() != 0 || !get<0>(value).fits_slong_p())
+                return false;
+            res = get<0>(value).get_si();
+            return true;
+        }
+
+        /// Get value as packed float if it is exactly representable
+        bool pack(const LiteralValue &value, double &res) {
+            if (value.index() != 1)
+                return false;
+            res = get<1>(value).get_d();
+            return std::isfinite(res) && Float(res) == get<1>(value);
+        }
+
+        /// Apply arithmetic operation to numbers; Float if any of them is Float
+        template<typename Op>
+        LiteralValue apply(const LiteralValue &a, const LiteralValue &b, Op op) {
+            return std::visit([op](const auto &x, const auto &y) -> LiteralValue {
+                using X = std::decay_t<decltype(x)>;
+                using Y = std::decay_t<decltype(y)>;
+                if constexpr (std::is_same_v<X, std::string> || std::is_same_v<Y, std::string>)
+                    throw std::invalid_argument("arithmetic operation on string");
+                else if constexpr (std::is_same_v<X, Integer> && std::is_same_v<Y, Integer>)
+                    return Integer(op(x, y));
+                else
+                    return Float(op(x, y));
+            }, a, b);
+        }
+
+        /// Compare numbers with numbers and strings with strings
+        template<typename Compare>
+        bool compare(const LiteralValue &a, const LiteralValue &b, Compare cmp) {
+            return std::visit([cmp](const auto &x, const auto &y) -> bool {
+                using X = std::decay_t<decltype(x)>;
+                using Y = std::decay_t<decltype(y)>;
+                if constexpr (std::is_same_v<X, std::string> != std::is_same_v<Y, std::string>)
+                    throw std::invalid_argument("comparison of string and number");
+                else
+                    return cmp(x, y);
+            }, a, b);
+        }
+
+        bool equals(const LiteralValue &a, const LiteralValue &b) {
+            if ((a.index() == 2) != (b.index() == 2))
+                return false;
+            return compare(a, b, std::equal_to<>());
+        }
+
+        /// r = a + b (or a - b if subtract is set); false on overflow
+        template<bool subtract>
+        bool addInts(const std::int64_t *a, const std::int64_t *b, std::int64_t *r, std::size_t n) {
+            auto ua = reinterpret_cast<const std::uint64_t *>(a), ub = reinterpret_cast<const std::uint64_t *>(b);
+            auto ur = reinterpret_cast<std::uint64_t *>(r);
+            std::uint64_t overflow = 0u;
+            std::size_t i = 0u;
+#ifdef NEPL_SIMD
+            UintBatch flags = 0u;
+            for (; i + UintBatch::size() <= n; i += UintBatch::size()) {
+                UintBatch x(ua + i, stdx::element_aligned), y(ub + i, stdx::element_aligned);
+                UintBatch z = subtract ? x - y : x + y;
+                flags |= subtract ? (x ^ y) & (x ^ z) : (x ^ z) & (y ^ z);
+                z.copy_to(ur + i, stdx::element_aligned);
+            }
+            overflow = stdx::reduce(flags, std::bit_or<>());
+#endif
+            for (; i < n; ++i) {
+                auto x = ua[i], y = ub[i], z = subtract ? x - y : x + y;
+                overflow |= subtract ? (x ^ y) & (x ^ z) : (x ^ z) & (y ^ z);
+                ur[i] = z;
+            }
+            return !(overflow >> 63u); //sign bit is set on overflow
+        }
+
+        /// r = a * b; false on overflow; scalar because there is no 64-bit vector multiplication in SSE/AVX2
+        bool mulInts(const std::int64_t *a, const std::int64_t *b, std::int64_t *r, std::size_t n) {
+            bool overflow = false;
+            for (std::size_t i = 0u; i < n; ++i)
+                overflow |= __builtin_mul_overflow(a[i], b[i], r + i);
+            return !overflow;
+        }
+
+        /// r = a + b (or a - b if subtract is set); false if any result is not exact or not finite
+        template<bool subtract>
+        bool addFloats(const double *a, const double *b, double *r, std::size_t n) {
+            //TwoSum: err is the exact rounding error of x + y, NaN if the sum overflows
+            auto inexact = [](auto x, auto y, auto &sum) {
+                sum = x + y;
+                auto yPart = sum - x;
+                return (x - (sum - yPart)) + (y - yPart) != 0.0;
+            };
+            std::size_t i = 0u;
+#ifdef NEPL_SIMD
+            for (; i + FloatBatch::size() <= n; i += FloatBatch::size()) {
+                FloatBatch x(a + i, stdx::element_aligned), y(b + i, stdx::element_aligned), sum;
+                if (stdx::any_of(inexact(x, subtract ? -y : y, sum)))
+                    return false;
+                sum.copy_to(r + i, stdx::element_aligned);
+            }
+#endif
+            for (; i < n; ++i)
+                if (inexact(a[i], subtract ? -b[i] : b[i], r[i]))
+                    return false;
+            return true;
+        }
+
+        /// r = a * b; false if any result is not exact or not finite
+        bool mulFloats(const double *a, const double *b, double *r, std::size_t n) {
+            //Dekker's product: exact error of a * b while halves of operands and the error don't overflow or underflow
+            auto split = [](double x, double &hi, double &lo) {
+                auto c = 134217729.0 * x; //2^27 + 1
+                hi = c - (c - x);
+                lo = x - hi;
+            };
+            for (std::size_t i = 0u; i < n; ++i) {
+                auto x = a[i], y = b[i], p = r[i] = x * y;
+                if (p == 0.0 && (x == 0.0 || y == 0.0))
+                    continue;
+                if (!(std::abs(x) <= 0x1p990 && std::abs(y) <= 0x1p990 && std::abs(p) >= 0x1p-900 &&
+                      std::abs(p) <= 0x1p1000))
+                    return false;
+                double xHi, xLo, yHi, yLo;
+                split(x, xHi, xLo);
+                split(y, yHi, yLo);
+                if (((xHi * yHi - p) + xHi * yLo + xLo * yHi) + xLo * yLo != 0.0)
+                    return false;
+            }
+            return true;
+        }
+
+        /// Sum of integers; false on overflow
+        bool sumInts(const std::int64_t *a, std::size_t n, std::int64_t &res) {
+            res = 0;
+            std::size_t i = 0u;
+#ifdef NEPL_SIMD
+            auto ua = reinterpret_cast<const std::uint64_t *>(a);
+            UintBatch acc = 0u, flags = 0u;
+            for (; i + UintBatch::size() <= n; i += UintBatch::size()) {
+                UintBatch x(ua + i, stdx::element_aligned), z = acc + x;
+                flags |= (acc ^ z) & (x ^ z);
+                acc = z;
+            }
+            if (stdx::reduce(flags, std::bit_or<>()) >> 63u)
+                return false;
+            for (std::size_t lane = 0u; lane < UintBatch::size(); ++lane)
+                if (__builtin_add_overflow(res, static_cast<std::int64_t>(acc[lane]), &res))
+                    return false;
+#endif
+            for (; i < n; ++i)
+                if (__builtin_add_overflow(res, a[i], &res))
+                    return false;
+            return true;
+        }
+
+        /// acc += x; false if the result is not exact or not finite
+        bool addExact(double &acc, double x) {
+            auto sum = acc + x, xPart = sum - acc;
+            if ((acc - (sum - xPart)) + (x - xPart) != 0.0)
+                return false;
+            acc = sum;
+            return true;
+        }
+
+        /// Sum of doubles in item order; false if any partial sum is not exact, as boxed sum would round it then
+        bool sumFloats(const double *a, std::size_t n, double &res) {
+            res = 0.0;
+            for (std::size_t i = 0u; i < n; ++i)
+                if (!addExact(res, a[i]))
+                    return false;
+            return true;
+        }
+
+        /// Least (or greatest if greatest is set) of n > 0 numbers
+        template<bool greatest, typename T>
+        T extreme(const T *a, std::size_t n) {
+            T res = a[0];
+            std::size_t i = 0u;
+#ifdef NEPL_SIMD
+            using Batch = stdx::native_simd<T>;
+            if (n >= Batch::size()) {
+                Batch acc(a, stdx::element_aligned);
+                for (i = Batch::size(); i + Batch::size() <= n; i += Batch::size()) {
+                    Batch x(a + i, stdx::element_aligned);
+                    acc = greatest ? stdx::max(acc, x) : stdx::min(acc, x);
+                }
+                res = greatest ? stdx::hmax(acc) : stdx::hmin(acc);
+            }
+#endif
+            for (; i < n; ++i)
+                res = greatest ? std::max(res, a[i]) : std::min(res, a[i]);
+            return res;
+        }
+
+        template<typename T>
+        bool equalRange(const T *a, const T *b, std::size_t n) {
+            std::size_t i = 0u;
+#ifdef NEPL_SIMD
+            using Batch = stdx::native_simd<T>;
+            for (; i + Batch::size() <= n; i += Batch::size())
+                if (stdx::any_of(Batch(a + i, stdx::element_aligned) != Batch(b + i, stdx::element_aligned)))
+                    return false;
+#endif
+            for (; i < n; ++i)
+                if (a[i] != b[i])
+                    return false;
+            return true;
+        }
+
+        /// r = cmp(a, b) as 1 or 0
+        template<typename T, typename Compare>
+        void compareRange(const T *a, const T *b, std::int64_t *r, std::size_t n, Compare cmp) {
+            std::size_t i = 0u;
+#ifdef NEPL_SIMD
+            using Batch = stdx::native_simd<T>;
+            if constexpr (Batch::size() == IntBatch::size()) {
+                for (; i + Batch::size() <= n; i += Batch::size()) {
+                    Batch flags = 0;
+                    stdx::where(cmp(Batch(a + i, stdx::element_aligned), Batch(b + i, stdx::element_aligned)),
+                                flags) = 1;
+                    stdx::static_simd_cast<IntBatch>(flags).copy_to(r + i, stdx::element_aligned);
+                }
+            }
+#endif
+            for (; i < n; ++i)
+                r[i] = cmp(a[i], b[i]);
+        }
+    }
+
+    List::List(const std::vector<LiteralValue> &values) {
+        for (const auto &value: values)
+            push_back(value);
+    }
+
+    std::size_t List::size() const noexcept {
+        return std::visit([](const auto &vector) { return vector.size(); }, items);
+    }
+
+    bool List::isPacked() const noexcept {
+        return items.index() != 2;
+    }
+
+    LiteralValue List::at(std::size_t index) const {
+        if (index >= size())
+            throw std::out_of_range("list index out of range");
+        switch (items.index()) {
+            case 0:
+                return Integer(static_cast<long>(get<0>(items)[index]));
+            case 1:
+                return Float(get<1>(items)[index]);
+            default:
+                return get<2>(items)[index];
+        }
+    }
+
+    std::vector<LiteralValue> &List::box() {
+        if (items.index() != 2) {
+            std::vector<LiteralValue> boxed;
+            boxed.reserve(size());
+            for (std::size_t i = 0u; i < size(); ++i)
+                boxed.push_back(at(i));
+            items = std::move(boxed);
+        }
+        return get<2>(items);
+    }
+
+    bool List::setPacked(std::size_t index, const LiteralValue &value) {
+        std::int64_t integer;
+        double floating;
+        if (auto ints = get_if<0>(&items); ints && pack(value, integer))
+            (*ints)[index] = integer;
+        else if (auto floats = get_if<1>(&items); floats && pack(value, floating))
+            (*floats)[index] = floating;
+        else
+            return false;
+        return true;
+    }
+
+    void List::set(std::size_t index, const LiteralValue &value) {
+        if (index >= size())
+            throw std::out_of_range("list index out of range");
+        if (!setPacked(index, value))
+            box()[index] = value;
+    }
+
+    void List::push_back(const LiteralValue &value) {
+        std::int64_t integer;
+        double floating;
+        if (size() == 0u) { //the first item chooses representation
+            if (pack(value, integer))
+                items = std::vector<std::int64_t>{integer};
+            else if (pack(value, floating))
+                items = std::vector<double>{floating};
+            else
+                items = std::vector<LiteralValue>{value};
+        } else if (auto ints = get_if<0>(&items); ints && pack(value, integer)) {
+            ints->push_back(integer);
+        } else if (auto floats = get_if<1>(&items); floats && pack(value, floating)) {
+            floats->push_back(floating);
+        } else {
+            box().push_back(value);
+        }
+    }
+
+    LiteralValue List::sum() const {
+        if (auto ints = get_if<0>(&items)) {
+            std::int64_t res;
+            if (sumInts(ints->data(), ints->size(), res))
+                return Integer(static_cast<long>(res));
+            Integer total;
+            for (auto item: *ints)
+                total += static_cast<long>(item);
+            return total;
+        }
+        if (auto floats = get_if<1>(&items)) {
+            double res;
+            if (sumFloats(floats->data(), floats->size(), res))
+                return Float(res);
+        }
+
+        LiteralValue res = Integer();
+        for (std::size_t i = 0u; i < size(); ++i)
+            res = apply(res, at(i), std::plus<>());
+        return res;
+    }
+
+    LiteralValue List::min() const {
+        if (size() == 0u)
+            throw std::out_of_range("minimum of empty list");
+        if (auto ints = get_if<0>(&items))
+            return Integer(static_cast<long>(extreme<false>(ints->data(), ints->size())));
+        if (auto floats = get_if<1>(&items))
+            return Float(extreme<false>(floats->data(), floats->size()));
+
+        const auto &boxed = get<2>(items);
+        auto res = &boxed.front();
+        for (const auto &item: boxed)
+            if (compare(item, *res, std::less<>()))
+                res = &item;
+        return *res;
+    }
+
+    LiteralValue List::max() const {
+        if (size() == 0u)
+            throw std::out_of_range("maximum of empty list");
+        if (auto ints = get_if<0>(&items))
+            return Integer(static_cast<long>(extreme<true>(ints->data(), ints->size())));
+        if (auto floats = get_if<1>(&items))
+            return Float(extreme<true>(floats->data(), floats->size()));
+
+        const auto &boxed = get<2>(items);
+        auto res = &boxed.front();
+        for (const auto &item: boxed)
+            if (compare(*res, item, std::less<>()))
+                res = &item;
+        return *res;
+    }
+
+    template<typename IntKernel, typename FloatKernel, typename Op>
+    List List::combine(const List &other, IntKernel intKernel, FloatKernel floatKernel, Op op) const {
+        auto n = size();
+        if (n != other.size())
+            throw std::invalid_argument("element-wise operation on lists of different sizes");
+
+        List res;
+        if (auto a = get_if<0>(&items), b = get_if<0>(&other.items); a && b) {
+            std::vector<std::int64_t> packed(n);
+            if (intKernel(a->data(), b->data(), packed.data(), n)) {
+                res.items = std::move(packed);
+                return res;
+            }
+        } else if (auto x = get_if<1>(&items), y = get_if<1>(&other.items); x && y) {
+            std::vector<double> packed(n);
+            if (floatKernel(x->data(), y->data(), packed.data(), n)) {
+                res.items = std::move(packed);
+                return res;
+            }
+        }
+
+        for (std::size_t i = 0u; i < n; ++i)
+            res.push_back(apply(at(i), other.at(i), op));
+        return res;
+    }
+
+    template<typename Compare, typename BoxedCompare>
+    List List::compareItems(const List &other, Compare cmp, BoxedCompare boxedCmp) const {
+        auto n = size();
+        if (n != other.size())
+            throw std::invalid_argument("element-wise comparison of lists of different sizes");
+
+        List res;
+        std::vector<std::int64_t> flags(n);
+        if (auto a = get_if<0>(&items), b = get_if<0>(&other.items); a && b) {
+            compareRange(a->data(), b->data(), flags.data(), n, cmp);
+        } else if (auto x = get_if<1>(&items), y = get_if<1>(&other.items); x && y) {
+            compareRange(x->data(), y->data(), flags.data(), n, cmp);
+        } else {
+            for (std::size_t i = 0u; i < n; ++i)
+                flags[i] = boxedCmp(at(i), other.at(i));
+        }
+        res.items = std::move(flags);
+        return res;
+    }
+
+    List List::operator+(const List &other) const {
+        return combine(other, addInts<false>, addFloats<false>, std::plus<>());
+    }
+
+    List List::operator-(const List &other) const {
+        return combine(other, addInts<true>, addFloats<true>, std::minus<>());
+    }
+
+    List List::operator*(const List &other) const {
+        return combine(other, mulInts, mulFloats, std::multiplies<>());
+    }
+
+    bool List::operator==(const List &other) const {
+        auto n = size();
+        if (n != other.size())
+            return false;
+        if (auto a = get_if<0>(&items), b = get_if<0>(&other.items); a && b)
+            return equalRange(a->data(), b->data(), n);
+        if (auto a = get_if<1>(&items), b = get_if<1>(&other.items); a && b)
+            return equalRange(a->data(), b->data(), n);
+        for (std::size_t i = 0u; i < n; ++i)
+            if (!equals(at(i), other.at(i)))
+                return false;
+        return true;
+    }
+
+    List List::equal(const List &other) const {
+        return compareItems(other, std::equal_to<>(), equals);
+    }
+
+    List List::less(const List &other) const {
+        return compareItems(other, std::less<>(), [](const LiteralValue &a, const LiteralValue &b) {
+            return compare(a, b, std::less<>());
+        });
+    }
+
+    List List::lessEqual(const List &other) const {
+        return compareItems(other, std::less_equal<>(), [](const LiteralValue &a, const LiteralValue &b) {
+            return compare(a, b, std::less_equal<>());
+        });
+    }
+}
@@ -0,0 +1,94 @@
+/** @file
+ * @brief Header for List class, the container indexed by IndexAstNode
+ */
+
+#ifndef NEPL_LIST_H
+#define NEPL_LIST_H
+
+#include <cstdint>
+#include <variant>
+#include <vector>
+#include "AST.h"
+
+namespace nepl {
+    /** @brief Sequence of values with compact storage of homogeneous numbers
+     *
+     * While all items are Integer fitting into 64 bits, or all items are Float exactly representable as double,
+     * they are stored packed in std::vector<std::int64_t> or std::vector<double>, and bulk operations run through
+     * SIMD kernels. Otherwise (the list has strings, mixed types or a value doesn't fit) items are stored boxed.
+     * When a packed result overflows or is not exact, the operation is redone on boxed values, so results
+     * don't depend on the storage.
+     */
+    class List {
+    protected:
+        /// Packed integers, packed floats or boxed values
+        std::variant<std::vector<std::int64_t>, std::vector<double>, std::vector<LiteralValue>> items;
+
+        /// Convert items to boxed values
+        std::vector<LiteralValue> &box();
+
+        /// Store value at index of packed items if it can be packed there
+        bool setPacked(std::size_t index, const LiteralValue &value);
+
+        /// Apply element-wise arithmetic operation; kernels return false if packed results overflow or are inexact
+        template<typename IntKernel, typename FloatKernel, typename Op>
+        [[nodiscard]] List combine(const List &other, IntKernel intKernel, FloatKernel floatKernel, Op op) const;
+
+        /// Apply element-wise comparison, cmp to packed items of the same kind and boxedCmp to others
+        template<typename Compare, typename BoxedCompare>
+        [[nodiscard]] List compareItems(const List &other, Compare cmp, BoxedCompare boxedCmp) const;
+
+    public:
+        List() = default;
+
+        explicit List(const std::vector<LiteralValue> &values);
+
+        /// Number of items
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        /// Are items stored in a packed buffer?
+        [[nodiscard]] bool isPacked() const noexcept;
+
+        /// Item at index, throws std::out_of_range
+        [[nodiscard]] LiteralValue at(std::size_t index) const;
+
+        /// Replace item at index, throws std::out_of_range
+        void set(std::size_t index, const LiteralValue &value);
+
+        /// Add an item at the end
+        void push_back(const LiteralValue &value);
+
+        /// Sum of numeric items, throws std::invalid_argument for strings
+        [[nodiscard]] LiteralValue sum() const;
+
+        /// Least item, throws std::out_of_range for empty list
+        [[nodiscard]] LiteralValue min() const;
+
+        /// Greatest item, throws std::out_of_range for empty list
+        [[nodiscard]] LiteralValue max() const;
+
+        /// Element-wise sum of lists of the same size, throws std::invalid_argument
+        List operator+(const List &other) const;
+
+        /// Element-wise difference of lists of the same size, throws std::invalid_argument
+        List operator-(const List &other) const;
+
+        /// Element-wise product of lists of the same size, throws std::invalid_argument
+        List operator*(const List &other) const;
+
+        /// Are lists of the same size with equal items?
+        bool operator==(const List &other) const;
+
+        /// Element-wise equality as Integer 1 or 0, throws std::invalid_argument for lists of different sizes
+        [[nodiscard]] List equal(const List &other) const;
+
+        /// Element-wise a < b as Integer 1 or 0, throws std::invalid_argument for lists of different sizes
+        /// or comparison of string and number
+        [[nodiscard]] List less(const List &other) const;
+
+        /// Element-wise a <= b as Integer 1 or 0, throws std::invalid_argument like less
+        [[nodiscard]] List lessEqual(const List &other) const;
+    };
+}
+
+#endif //NEPL_LIST_H
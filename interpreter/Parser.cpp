@@ -25,7 +25,7 @@ namespace nepl {
 
     OperatorValue::OperatorValue(std::string function) : function(std::move(function)) {}
 
-    Parser::Parser(Lexer lexer) : lexer(lexer), curToken(nextToken()), operators() {}
+    Parser::Parser(Lexer lexer) : lexer(lexer), curToken(this->lexer.nextToken()), operators() {}
 
     Token Parser::nextToken() {
         return curToken = lexer.nextToken();
@@ -33,8 +33,8 @@ namespace nepl {
 
     std::vector<std::unique_ptr<IAstNode>> Parser::getAstNodes() {
         std::vector<std::unique_ptr<IAstNode>> res;
-        while (!lexer.source.eof())
-            res.push_back(nextAstNode());
+        while (auto node = nextAstNode())
+            res.push_back(std::move(node));
         return res;
     }
 
@@ -157,6 +157,8 @@ namespace nepl {
                     disableOperator();
                     break;
                 case TokenType::SEMICOLON:
+                    if (lexer.source.eof())
+                        return nullptr; //lexer returns semicolons endlessly at the end of input
                     nextToken();
                     break;
                 default:
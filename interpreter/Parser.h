@@ -75,7 +75,7 @@ namespace nepl {
     public:
         explicit Parser(Lexer lexer);
 
-        /// Get next built tree
+        /// Get next built tree, nullptr at the end of input
         std::unique_ptr<IAstNode> nextAstNode();
 
         /// Result list of built trees
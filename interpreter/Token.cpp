@@ -17,13 +17,17 @@ std::ostream &operator<<(std::ostream &os, const TokenValue &value) {
 }
 
 namespace nepl {
-    std::ostream &operator<<(std::ostream &os, const TokenType &type) {
+    const char *tokenTypeName(TokenType type) {
         static const char *TOKEN_TYPES[] = {
                 "IDENTIFIER", "STRING", "INTEGER", "FLOAT", "LEFT_PARENTHESIS", "RIGHT_PARENTHESIS",
                 "LEFT_SQUARE_BRACKET", "RIGHT_SQUARE_BRACKET", "LEFT_BRACE", "RIGHT_BRACE",
                 "SEMICOLON", "COMMA", "DOT", "OPERATOR", "UNOPERATOR",
         };
-        return os << TOKEN_TYPES[static_cast<unsigned>(type)];
+        return TOKEN_TYPES[static_cast<unsigned>(type)];
+    }
+
+    std::ostream &operator<<(std::ostream &os, const TokenType &type) {
+        return os << tokenTypeName(type);
     }
 
     TokenType operator+(TokenType type, char add) {
@@ -28,6 +28,9 @@ namespace nepl {
 
     TokenType operator+(TokenType type, char add);
 
+    /// Name of the token type, e.g. "IDENTIFIER"
+    const char *tokenTypeName(TokenType type);
+
     std::ostream &operator<<(std::ostream &os, const TokenType &type);
 
     /// Minimal significant piece of code (a word or operator, etc.)
@@ -1,7 +1,8 @@
 #include <fstream>
 #include <boost/program_options.hpp>
 
-#include "Lexer.h"
+#include "Parser.h"
+#include "Emitter.h"
 
 namespace po = boost::program_options;
 
@@ -9,7 +10,9 @@ int main(int argc, char *argv[]) {
     po::options_description desc;
     desc.add_options()
             ("help,h", "Show help")
-            ("source,s", po::value<std::string>(), "Source code filename");
+            ("source,s", po::value<std::string>(), "Source code filename")
+            ("emit,e", po::value<std::string>()->default_value("tokens"), "What to output: tokens or ast")
+            ("format,f", po::value<std::string>()->default_value("text"), "Output format: text, jsonl or binary");
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
     po::notify(vm);
@@ -19,6 +22,28 @@ int main(int argc, char *argv[]) {
         return EXIT_SUCCESS;
     }
 
+    nepl::EmitKind kind;
+    if (vm["emit"].as<std::string>() == "tokens") {
+        kind = nepl::EmitKind::TOKENS;
+    } else if (vm["emit"].as<std::string>() == "ast") {
+        kind = nepl::EmitKind::AST;
+    } else {
+        std::cerr << "Unknown emit mode \"" << vm["emit"].as<std::string>() << "\"!\n";
+        return EXIT_FAILURE;
+    }
+
+    nepl::EmitFormat format;
+    if (vm["format"].as<std::string>() == "text") {
+        format = nepl::EmitFormat::TEXT;
+    } else if (vm["format"].as<std::string>() == "jsonl") {
+        format = nepl::EmitFormat::JSONL;
+    } else if (vm["format"].as<std::string>() == "binary") {
+        format = nepl::EmitFormat::BINARY;
+    } else {
+        std::cerr << "Unknown format \"" << vm["format"].as<std::string>() << "\"!\n";
+        return EXIT_FAILURE;
+    }
+
     if (vm.count("source")) {
         std::ifstream source(vm["source"].as<std::string>());
         if (source.fail()) {
@@ -26,11 +51,23 @@ int main(int argc, char *argv[]) {
             return EXIT_FAILURE;
         }
 
-        nepl::Lexer lexer(source);
-
-        std::cout << "Found tokens:\n";
-        while (!lexer.source.eof())
-            std::cout << lexer.nextToken() << '\n';
+        try {
+            if (kind == nepl::EmitKind::TOKENS && format == nepl::EmitFormat::TEXT)
+                std::cout << "Found tokens:\n";
+            nepl::Emitter emitter(std::cout, format, kind);
+            if (kind == nepl::EmitKind::TOKENS) {
+                nepl::Lexer lexer(source);
+                while (!lexer.source.eof())
+                    emitter.emit(lexer.nextToken());
+            } else {
+                nepl::Parser parser{nepl::Lexer(source)};
+                while (auto node = parser.nextAstNode())
+                    emitter.emit(*node);
+            }
+        } catch (const nepl::SyntaxError &error) {
+            std::cerr << "Syntax error: " << error.what() << '\n';
+            return EXIT_FAILURE;
+        }
     } else {
         std::cerr << "No input files specified. Use --help or -h to see help.\n";
     }
@@ -0,0 +1,114 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../Emitter.h"
+#include "../Parser.h"
+
+using namespace nepl;
+using namespace std::string_literals;
+
+std::string emitTokens(EmitFormat format, const std::vector<Token> &tokens) {
+    std::stringstream out;
+    {
+        Emitter emitter(out, format, EmitKind::TOKENS);
+        for (const auto &token: tokens)
+            emitter.emit(token);
+    }
+    return out.str();
+}
+
+std::string emitTree(EmitFormat format, const IAstNode &node) {
+    std::stringstream out;
+    {
+        Emitter emitter(out, format, EmitKind::AST);
+        emitter.emit(node);
+    }
+    return out.str();
+}
+
+void testTokens() {
+    std::vector<Token> tokens{
+            Token(TokenType::INTEGER, Integer(-258), 3u),
+            Token(TokenType::STRING, "a\"b\n\x01"s, 1u),
+            Token(TokenType::FLOAT, Float(0.25), 2u),
+            Token(TokenType::SEMICOLON, nullptr, 2u),
+    };
+
+    assert(emitTokens(EmitFormat::TEXT, tokens) ==
+           "INTEGER@3: -258\n"
+           "STRING@1: a\"b\n\x01\n"
+           "FLOAT@2: 0.25\n"
+           "SEMICOLON@2\n");
+
+    assert(emitTokens(EmitFormat::JSONL, tokens) ==
+           "{\"type\":\"INTEGER\",\"line\":3,\"value\":-258}\n"
+           "{\"type\":\"STRING\",\"line\":1,\"value\":\"a\\\"b\\n\\u0001\"}\n"
+           "{\"type\":\"FLOAT\",\"line\":2,\"value\":0.25}\n"
+           "{\"type\":\"SEMICOLON\",\"line\":2}\n");
+
+    //-258 is sign 1 and magnitude 02 01, 0.25 is the 4-byte string "0.25"
+    assert(emitTokens(EmitFormat::BINARY, tokens) ==
+           "NEPL\x01\x00"s
+           "\x02" "\x03\x00\x00\x00" "\x01" "\x02\x00\x00\x00" "\x02\x01"s
+           "\x01" "\x01\x00\x00\x00" "\x05\x00\x00\x00" "a\"b\n\x01"s
+           "\x03" "\x02\x00\x00\x00" "\x04\x00\x00\x00" "0.25"s
+           "\x0a" "\x02\x00\x00\x00"s);
+
+    //zero has no magnitude bytes
+    assert(emitTokens(EmitFormat::BINARY, {Token(TokenType::INTEGER, Integer(), 0u)}) ==
+           "NEPL\x01\x00" "\x02" "\x00\x00\x00\x00" "\x00" "\x00\x00\x00\x00"s);
+}
+
+void testTree() {
+    std::stringstream source("f.g[300]\n");
+    Parser parser{Lexer(source)};
+    auto tree = parser.nextAstNode();
+    assert(tree);
+
+    assert(emitTree(EmitFormat::TEXT, *tree) ==
+           "Index\n"
+           "  container: Member g\n"
+           "    parent: Identifier f\n"
+           "  index: Literal 300\n");
+
+    assert(emitTree(EmitFormat::JSONL, *tree) ==
+           "{\"node\":\"Index\",\"container\":{\"node\":\"Member\",\"name\":\"g\","
+           "\"parent\":{\"node\":\"Identifier\",\"name\":\"f\"}},\"index\":{\"node\":\"Literal\",\"value\":300}}\n");
+
+    //300 is integer literal (value index 0) with sign 0 and magnitude 2c 01
+    assert(emitTree(EmitFormat::BINARY, *tree) ==
+           "NEPL\x01\x01"s
+           "\x04"
+           "\x02" "\x01\x00\x00\x00" "g"
+           "\x01" "\x01\x00\x00\x00" "f"
+           "\x00" "\x00" "\x00" "\x02\x00\x00\x00" "\x2c\x01"s);
+
+    LiteralAstNode string("q\"\t\x1f"s), number(Float(-1.5));
+    assert(emitTree(EmitFormat::TEXT, string) == "Literal \"q\\\"\\t\\u001f\"\n");
+    assert(emitTree(EmitFormat::JSONL, string) == "{\"node\":\"Literal\",\"value\":\"q\\\"\\t\\u001f\"}\n");
+    assert(emitTree(EmitFormat::BINARY, string) ==
+           "NEPL\x01\x01" "\x00" "\x02" "\x04\x00\x00\x00" "q\"\t\x1f"s);
+    assert(emitTree(EmitFormat::BINARY, number) ==
+           "NEPL\x01\x01" "\x00" "\x01" "\x04\x00\x00\x00" "-1.5"s);
+}
+
+/// Lexer returns semicolons endlessly at the end of input, the parser must stop there
+void testEndOfInput() {
+    std::stringstream source("a\n\n\n");
+    Parser parser{Lexer(source)};
+    auto node = parser.nextAstNode();
+    assert(node);
+    assert(emitTree(EmitFormat::TEXT, *node) == "Identifier a\n");
+    assert(!parser.nextAstNode());
+}
+
+int main() {
+    testTokens();
+    testTree();
+    testEndOfInput();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,144 @@
+#undef NDEBUG
+
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "../Heap.h"
+
+using namespace nepl;
+
+/// Object with a payload needing destruction and two references, like a person with spouse
+struct Node : Managed<Node> {
+    static inline long alive = 0;
+
+    long id;
+    std::string name;
+    GcPtr<Node> left, right;
+
+    explicit Node(long id) : id(id), name("node " + std::to_string(id)) {
+        ++alive;
+    }
+
+    Node(Node &&other) noexcept: id(other.id), name(std::move(other.name)), left(other.left), right(other.right) {
+        ++alive;
+    }
+
+    ~Node() override {
+        --alive;
+    }
+
+    void trace(Tracer &tracer) override {
+        tracer(left);
+        tracer(right);
+    }
+
+    [[nodiscard]] bool valid() const {
+        return name == "node " + std::to_string(id);
+    }
+};
+
+/// Object which captures another one in constructor, like a closure with its environment
+struct Closure : Managed<Closure> {
+    GcPtr<Node> env;
+
+    explicit Closure(Handle<Node> &env) {
+        Heap::write(this, this->env, env.get());
+    }
+
+    void trace(Tracer &tracer) override {
+        tracer(env);
+    }
+};
+
+HeapConfig smallConfig() {
+    HeapConfig config;
+    config.nurserySize = 4u << 10u;
+    config.survivorSize = 1u << 10u;
+    config.majorThreshold = 64u << 10u;
+    return config;
+}
+
+/// Allocate garbage until the next minor collection
+void collectMinor(Heap &heap) {
+    auto collections = heap.getStats().minorCollections;
+    while (heap.getStats().minorCollections == collections)
+        heap.make<Node>(-1);
+}
+
+void testCycles() {
+    {
+        Heap heap(smallConfig());
+        {
+            Handle<Node> a(heap, heap.make<Node>(1));
+            Handle<Node> b(heap, heap.make<Node>(2));
+            Heap::write(a.get(), a->right, b.get());
+            Heap::write(b.get(), b->right, a.get());
+            heap.collect(); //both are promoted
+            assert(a->right.get() == b.get() && b->right.get() == a.get());
+        }
+        heap.collect();
+        assert(Node::alive == 0);
+        assert(heap.oldSpaceSize() == 0u);
+        assert(heap.getStats().bytesReclaimed > 0u);
+    }
+    assert(Node::alive == 0);
+}
+
+void testRootsAfterRelocation() {
+    Heap heap(smallConfig());
+    Handle<Node> root(heap, heap.make<Node>(7));
+    auto address = root.get();
+    for (int i = 0; i < 5; ++i)
+        collectMinor(heap);
+    assert(root.get() != address);
+    assert(root->id == 7 && root->valid());
+}
+
+void testSurvivorOverflow() {
+    Heap heap(smallConfig());
+    std::vector<Handle<Node>> nodes;
+    for (long i = 0; i < 100; ++i) //more than survivor space can hold
+        nodes.emplace_back(heap, heap.make<Node>(i));
+    collectMinor(heap);
+    assert(heap.getStats().bytesPromoted > 0u);
+    for (long i = 0; i < 100; ++i)
+        assert(nodes[i]->id == i && nodes[i]->valid());
+}
+
+void testCardBarrier() {
+    Heap heap(smallConfig());
+    Handle<Node> parent(heap, heap.make<Node>(1));
+    heap.collect(); //parent is old now
+    auto promoted = heap.getStats().bytesPromoted;
+    {
+        Handle<Node> child(heap, heap.make<Node>(2));
+        Heap::write(parent.get(), parent->left, child.get());
+    }
+    for (int i = 0; i < 5; ++i) { //child is reachable only through the card of parent
+        collectMinor(heap);
+        assert(parent->left->id == 2 && parent->left->valid());
+    }
+    assert(heap.getStats().bytesPromoted > promoted);
+    assert(heap.getStats().majorCollections == 1u);
+}
+
+void testMovedArgument() {
+    Heap heap(smallConfig());
+    Handle<Node> env(heap, heap.make<Node>(3));
+    for (int i = 0; i < 1000; ++i) { //some of these allocations collect and move env
+        auto closure = heap.make<Closure>(env);
+        assert(closure->env.get() == env.get());
+        assert(closure->env->valid());
+    }
+}
+
+int main() {
+    testCycles();
+    testRootsAfterRelocation();
+    testSurvivorOverflow();
+    testCardBarrier();
+    testMovedArgument();
+    assert(Node::alive == 0);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,162 @@
+#undef NDEBUG
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include "../List.h"
+
+using namespace nepl;
+
+bool equal(const LiteralValue &a, const LiteralValue &b) {
+    return a.index() == b.index() && a == b;
+}
+
+/// Packed integer kernels against the same operations on GMP numbers
+void testIntKernels() {
+    std::mt19937_64 random(2024u);
+    for (int run = 0; run < 2000; ++run) {
+        auto size = random() % 40u;
+        std::vector<Integer> x, y;
+        List a, b;
+        for (std::size_t i = 0u; i < size; ++i) {
+            //mostly small values, sometimes values near the limits to overflow
+            auto value = [&] {
+                auto bits = random();
+                return static_cast<long>(random() % 8u ? bits % 2001u : bits) - (random() % 8u ? 1000 : 0);
+            };
+            x.emplace_back(value());
+            y.emplace_back(value());
+            a.push_back(x.back());
+            b.push_back(y.back());
+        }
+        assert(a.isPacked() && b.isPacked());
+
+        auto sum = a + b, difference = a - b, product = a * b;
+        auto same = a.equal(b), less = a.less(b), lessEqual = a.lessEqual(b);
+        Integer total;
+        for (std::size_t i = 0u; i < size; ++i) {
+            assert(equal(sum.at(i), Integer(x[i] + y[i])));
+            assert(equal(difference.at(i), Integer(x[i] - y[i])));
+            assert(equal(product.at(i), Integer(x[i] * y[i])));
+            assert(equal(same.at(i), Integer(x[i] == y[i])));
+            assert(equal(less.at(i), Integer(x[i] < y[i])));
+            assert(equal(lessEqual.at(i), Integer(x[i] <= y[i])));
+            total += x[i];
+        }
+        assert(equal(a.sum(), total));
+        if (size) {
+            assert(equal(a.min(), *std::min_element(x.begin(), x.end())));
+            assert(equal(a.max(), *std::max_element(x.begin(), x.end())));
+        }
+        assert(a == a && (a == b) == (x == y));
+    }
+}
+
+void testIntOverflow() {
+    List big({Integer(LONG_MAX), Integer(LONG_MIN), Integer(3)}), one({Integer(1), Integer(-1), Integer(1)});
+    auto sum = big + one;
+    assert(!sum.isPacked());
+    assert(equal(sum.at(0), Integer(Integer(LONG_MAX) + 1)));
+    assert(equal(sum.at(1), Integer(Integer(LONG_MIN) - 1)));
+    assert(equal((big * big).at(0), Integer(Integer(LONG_MAX) * LONG_MAX)));
+    assert(equal(List({Integer(LONG_MAX), Integer(LONG_MAX)}).sum(), Integer(Integer(LONG_MAX) * 2)));
+
+    List list({Integer(1), Integer(2)});
+    list.push_back(Integer("100000000000000000000"));
+    assert(!list.isPacked());
+    assert(equal(list.at(2), Integer("100000000000000000000")));
+}
+
+void testFloatEdgeCases() {
+    assert(!List({Float("1e400")}).isPacked());
+    assert(!List({Float("0.1")}).isPacked());
+    assert(List({Float(0.5), Float(-2.25)}).isPacked());
+
+    List huge({Float(1e308), Float(1e308)});
+    assert(equal(huge.sum(), Float(Float(1e308) * 2)));
+    List large({Float(1e300)}), tiny({Float(1e-200)});
+    assert(equal((large * large).at(0), Float(Float(1e300) * Float(1e300))));
+    assert(equal((tiny * tiny).at(0), Float(Float(1e-200) * Float(1e-200))));
+
+    //the packed result must be the same as the boxed one
+    List precise({Float(1.0), Float(std::ldexp(1.0, -60))});
+    assert(equal(precise.sum(), Float(Float(1.0) + Float(std::ldexp(1.0, -60)))));
+    //2^200 + 1 is rounded by boxed sum, so the packed one must give up though the total is exact
+    auto big = std::ldexp(1.0, 200);
+    List cancelled({Float(big), Float(1.0), Float(-big), Float(0.0)});
+    assert(cancelled.isPacked());
+    auto boxedSum = List({Float(big), Float(1.0), Float(-big), Integer(0)}).sum();
+    assert(equal(cancelled.sum(), boxedSum));
+    List exact({Float(1.5), Float(2.5), Float(0.25), Float(-8.0), Float(0.125)});
+    auto result = exact * exact + exact - exact;
+    assert(result.isPacked());
+    assert(equal(result.sum(), Float(2.25 + 6.25 + 0.0625 + 64.0 + 0.015625)));
+    assert(equal(exact.min(), Float(-8.0)) && equal(exact.max(), Float(2.5)));
+}
+void testComparisons() {
+    List floats({Float(0.5), Float(-1.0), Float(2.0), Float(3.0), Float(1e300)});
+    List others({Float(0.5), Float(1.0), Float(-2.0), Float(3.5), Float(-1e300)});
+    assert(floats.less(others) == List({Integer(0), Integer(1), Integer(0), Integer(1), Integer(0)}));
+    assert(floats.lessEqual(others) == List({Integer(1), Integer(1), Integer(0), Integer(1), Integer(0)}));
+    assert(floats.equal(others).isPacked());
+    assert(floats.equal(others) == List({Integer(1), Integer(0), Integer(0), Integer(0), Integer(0)}));
+
+    //integers against floats and strings are compared boxed
+    List ints({Integer(1), Integer(2), Integer(3)}), halves({Float(1.0), Float(2.5), Float(2.5)});
+    assert(ints.less(halves) == List({Integer(0), Integer(1), Integer(0)}));
+    List words({std::string("a"), Integer(2), std::string("c")});
+    assert(words.equal(List({std::string("a"), std::string("2"), std::string("b")}))
+           == List({Integer(1), Integer(0), Integer(0)}));
+    assert(words.lessEqual(List({std::string("b"), Float(2.0), std::string("c")}))
+           == List({Integer(1), Integer(1), Integer(1)}));
+
+    bool thrown = false;
+    try {
+        (void) words.less(ints);
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    assert(thrown);
+    thrown = false;
+    try {
+        (void) ints.equal(floats);
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+void testMixed() {
+    List ints({Integer(1), Integer(2), Integer(3)}), floats({Float(0.5), Float(1.0), Float(1.5)});
+    auto sum = ints + floats;
+    assert(sum.isPacked());
+    assert(equal(sum.at(2), Float(4.5)));
+    assert(ints == List({Float(1.0), Float(2.0), Float(3.0)}));
+
+    List mixed({Integer(1), Float(0.5), Integer(2)});
+    assert(!mixed.isPacked());
+    assert(equal(mixed.sum(), Float(3.5)));
+    assert(equal(mixed.min(), Float(0.5)) && equal(mixed.max(), Integer(2)));
+
+    ints.set(1, std::string("two"));
+    assert(!ints.isPacked() && equal(ints.at(1), std::string("two")));
+    bool thrown = false;
+    try {
+        (void) ints.sum();
+    } catch (const std::invalid_argument &) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+int main() {
+    testIntKernels();
+    testIntOverflow();
+    testFloatEdgeCases();
+    testComparisons();
+    testMixed();
+    return EXIT_SUCCESS;
+}